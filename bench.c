@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <time.h>
+
+#include "chip8.h"
+#include "translated.h"
+
+/*
+ * Benchmark the ahead-of-time translation of a ROM against the interpreter.
+ *
+ * Both run headless (no window, renderer or audio) for the same number of
+ * frames with the same random seed, then their final states are compared.
+ * Each is run several times and the best time is reported.
+ *
+ * Usage:
+ *   ./bench /path/to/game_rom.ch8 [frames]
+ */
+
+#define RUNS 5
+
+
+/**
+ * Reset a Chip-8 and load the ROM, without a window, renderer or audio
+ */
+static bool setup(Chip8* chip8, const char* path) {
+    initialize_chip8(chip8);
+    chip8->display.window = NULL;
+    chip8->display.renderer = NULL;
+    memset(chip8->display.bits, 0, sizeof(chip8->display.bits));
+    chip8->running = true;
+
+    return load_rom(chip8, path) > 0;
+}
+
+
+/**
+ * Run a ROM for a number of frames and return the time taken in seconds
+ */
+static double run(Chip8* chip8, int frames, int instr_per_frame, bool translated) {
+    srand(1); // Same random numbers for both runs
+    if (translated)
+        reset_translated();
+
+    clock_t start = clock();
+
+    for (int frame = 0; frame < frames; frame++) {
+        if (translated) {
+            run_translated(chip8, instr_per_frame);
+        } else {
+            for (int i = 0; i < instr_per_frame; i++)
+                fetch_decode_execute(chip8);
+        }
+
+        if (chip8->delay_timer > 0)
+            chip8->delay_timer--;
+        if (chip8->sound_timer > 0)
+            chip8->sound_timer--;
+    }
+
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    if (seconds <= 0) // Faster than the clock can measure
+        seconds = 1.0 / CLOCKS_PER_SEC;
+    return seconds;
+}
+
+
+/**
+ * Check the interpreter and translated runs ended up in the same state
+ */
+static bool same_state(const Chip8* a, const Chip8* b) {
+    return memcmp(a->mem, b->mem, sizeof(a->mem)) == 0
+        && memcmp(a->Vx, b->Vx, sizeof(a->Vx)) == 0
+        && memcmp(a->stack, b->stack, sizeof(a->stack)) == 0
+        && memcmp(a->display.bits, b->display.bits, sizeof(a->display.bits)) == 0
+        && a->I == b->I
+        && a->PC == b->PC
+        && a->SP == b->SP
+        && a->delay_timer == b->delay_timer
+        && a->sound_timer == b->sound_timer;
+}
+
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s /path/to/game_rom.ch8 [frames]\n", argv[0]);
+        return 1;
+    }
+
+    int frames = (argc > 2) ? atoi(argv[2]) : 20000000; // ~1 s interpreted
+    int instr_per_frame = 500 / 60; // Same speed as the emulator
+
+    static Chip8 interpreted;
+    static Chip8 translated;
+    double interpreted_s = 0;
+    double translated_s = 0;
+
+    for (int i = 0; i < RUNS; i++) {
+        if (!setup(&interpreted, argv[1]) || !setup(&translated, argv[1])) {
+            fprintf(stderr, "Couldn't load %s\n", argv[1]);
+            return 1;
+        }
+
+        double s = run(&interpreted, frames, instr_per_frame, false);
+        if (i == 0 || s < interpreted_s)
+            interpreted_s = s;
+
+        s = run(&translated, frames, instr_per_frame, true);
+        if (i == 0 || s < translated_s)
+            translated_s = s;
+
+        if (!same_state(&interpreted, &translated)) {
+            printf("MISMATCH: translated run diverged from the interpreter\n");
+            return 1;
+        }
+    }
+
+    long instructions = (long)frames * instr_per_frame;
+
+    printf("%ld instructions (%d frames), best of %d runs\n", instructions, frames, RUNS);
+    printf("interpreter: %8.3f s  %8.2f MIPS\n",
+        interpreted_s, instructions / interpreted_s / 1e6);
+    printf("translated:  %8.3f s  %8.2f MIPS\n",
+        translated_s, instructions / translated_s / 1e6);
+    printf("speedup:     %8.2fx\n", interpreted_s / translated_s);
+    printf("final states match\n");
+
+    return 0;
+}
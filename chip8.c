@@ -4,6 +4,67 @@
 #include "chip8.h"
 
 
+/**
+ * Reset memory, registers and keyboard, and load the font
+ */
+void initialize_chip8(Chip8* chip8) {
+
+    // Initialize memory 
+    memset(chip8->mem, 0, sizeof(chip8->mem));
+    uint8_t font[80] = { // Store font in first 512 bytes in memory
+        0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
+        0x20, 0x60, 0x20, 0x20, 0x70, // 1
+        0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
+        0xF0, 0x10, 0xF0, 0x10, 0xF0, // 3
+        0x90, 0x90, 0xF0, 0x10, 0x10, // 4
+        0xF0, 0x80, 0xF0, 0x10, 0xF0, // 5
+        0xF0, 0x80, 0xF0, 0x90, 0xF0, // 6
+        0xF0, 0x10, 0x20, 0x40, 0x40, // 7
+        0xF0, 0x90, 0xF0, 0x90, 0xF0, // 8
+        0xF0, 0x90, 0xF0, 0x10, 0xF0, // 9
+        0xF0, 0x90, 0xF0, 0x90, 0x90, // A
+        0xE0, 0x90, 0xE0, 0x90, 0xE0, // B
+        0xF0, 0x80, 0x80, 0x80, 0xF0, // C
+        0xE0, 0x90, 0x90, 0x90, 0xE0, // D
+        0xF0, 0x80, 0xF0, 0x80, 0xF0, // E
+        0xF0, 0x80, 0xF0, 0x80, 0x80, // F
+    }; 
+    memcpy(&chip8->mem[0], font, sizeof(font));
+
+    // Initialize registers
+    memset(chip8->Vx, 0, sizeof(chip8->Vx));
+    chip8->I = 0x000; 
+    chip8->delay_timer = 0;
+    chip8->sound_timer = 0;
+    chip8->PC = 0x200;
+    memset(chip8->stack, 0, sizeof(chip8->stack));
+    chip8->SP = -1;
+
+    // Initialize keyboard
+    memset(chip8->keyboard.pressed, 0, sizeof(chip8->keyboard.pressed));
+    chip8->keyboard.expecting_key = 0;
+    chip8->keyboard.expecting_release = false;
+
+    return;
+}
+
+
+/**
+ * Load a ROM into memory starting at 0x200
+ * Returns the number of bytes loaded, or 0 if the ROM couldn't be read
+ */
+size_t load_rom(Chip8* chip8, const char* path) {
+    FILE* rom_file = fopen(path, "rb");
+    if (rom_file == NULL)
+        return 0;
+
+    size_t size = fread(&chip8->mem[0x200], 1, 4096 - 512, rom_file);
+    fclose(rom_file);
+
+    return size;
+}
+
+
 /**
  * Read and store the key the user has pressed or released 
  */
@@ -51,6 +51,19 @@ typedef struct Chip8 {
 } Chip8;
 
 
+/**
+ * Reset memory, registers and keyboard, and load the font
+ */
+void initialize_chip8(Chip8* chip8);
+
+
+/**
+ * Load a ROM into memory starting at 0x200
+ * Returns the number of bytes loaded, or 0 if the ROM couldn't be read
+ */
+size_t load_rom(Chip8* chip8, const char* path);
+
+
 /**
  * Read and store the key the user has pressed or released 
  */
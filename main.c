@@ -1,6 +1,9 @@
 #include <time.h>
 
 #include "chip8.h"
+#ifdef CHIP8_AOT
+#include "translated.h"
+#endif
 
 
 int main(int argc, char** argv) {
@@ -15,44 +18,17 @@ int main(int argc, char** argv) {
     chip8.display.renderer = SDL_CreateRenderer(chip8.display.window, -1, SDL_RENDERER_ACCELERATED);
     memset(chip8.display.bits, 0, sizeof(chip8.display.bits));
 
-    // Initialize memory 
-    memset(chip8.mem, 0, sizeof(chip8.mem));
-    uint8_t font[80] = { // Store font in first 512 bytes in memory
-        0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
-        0x20, 0x60, 0x20, 0x20, 0x70, // 1
-        0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
-        0xF0, 0x10, 0xF0, 0x10, 0xF0, // 3
-        0x90, 0x90, 0xF0, 0x10, 0x10, // 4
-        0xF0, 0x80, 0xF0, 0x10, 0xF0, // 5
-        0xF0, 0x80, 0xF0, 0x90, 0xF0, // 6
-        0xF0, 0x10, 0x20, 0x40, 0x40, // 7
-        0xF0, 0x90, 0xF0, 0x90, 0xF0, // 8
-        0xF0, 0x90, 0xF0, 0x10, 0xF0, // 9
-        0xF0, 0x90, 0xF0, 0x90, 0x90, // A
-        0xE0, 0x90, 0xE0, 0x90, 0xE0, // B
-        0xF0, 0x80, 0x80, 0x80, 0xF0, // C
-        0xE0, 0x90, 0x90, 0x90, 0xE0, // D
-        0xF0, 0x80, 0xF0, 0x80, 0xF0, // E
-        0xF0, 0x80, 0xF0, 0x80, 0x80, // F
-    }; 
-    memcpy(&chip8.mem[0], font, sizeof(font));
+    // Initialize memory, registers and keyboard
+    initialize_chip8(&chip8);
 
     // Load ROM into memory
-    uint16_t start = 0x200;
-    uint8_t* start_addr = &chip8.mem[start];
-    FILE* rom_file = NULL;
-    rom_file = fopen(argv[1], "rb");
-    fread(start_addr, 4096 - 512, 1, rom_file);
-    fclose(rom_file);
-
-    // Initialize registers
-    memset(chip8.Vx, 0, sizeof(chip8.Vx));
-    chip8.I = 0x000; 
-    chip8.delay_timer = 0;
-    chip8.sound_timer = 0;
-    chip8.PC = 0x200;
-    memset(chip8.stack, 0, sizeof(chip8.stack));
-    chip8.SP = -1;
+    if (argc < 2 || load_rom(&chip8, argv[1]) == 0) {
+        fprintf(stderr, "Usage: %s /path/to/game_rom.ch8\n", argv[0]);
+        SDL_DestroyRenderer(chip8.display.renderer);
+        SDL_DestroyWindow(chip8.display.window);
+        SDL_Quit();
+        return 1;
+    }
 
     // Calculate instructions per frame 
     int cpu_freq = 500;                               // instructions per second
@@ -60,10 +36,6 @@ int main(int argc, char** argv) {
     int frame_ms = 1000 / refresh_rate;               // time (in ms) per frame
     int instr_per_frame = cpu_freq / refresh_rate;
 
-    // Initialize keyboard
-    memset(chip8.keyboard.pressed, 0, sizeof(chip8.keyboard.pressed));
-    chip8.keyboard.expecting_release = false;
-
     /*
      * Set up audio for sound timer beep
      * https://wiki.libsdl.org/SDL2/SDL_OpenAudioDevice
@@ -92,8 +64,12 @@ int main(int argc, char** argv) {
         process_user_keyboard_input(&chip8); 
 
         // Each frame should do a fixed number of instructions 
+#ifdef CHIP8_AOT
+        run_translated(&chip8, instr_per_frame);
+#else
         for (int i = 0; i < instr_per_frame; i++)  
             fetch_decode_execute(&chip8);
+#endif
 
         uint32_t end_ms = SDL_GetTicks();
         uint32_t time_taken_ms = end_ms - start_ms;
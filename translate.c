@@ -0,0 +1,717 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * Ahead-of-time translator from a Chip-8 ROM to C.
+ *
+ * Recovers the control-flow graph of a ROM by following jumps, calls and
+ * skips from 0x200, splits it into basic blocks, and emits a C file with
+ * one function per block. The generated file links against chip8.c and
+ * provides run_translated() (see translated.h).
+ *
+ * Usage:
+ *   ./translate [-o out.c] rom.ch8   Emit C translation (stdout by default)
+ *   ./translate -d rom.ch8           Disassemble and dump the CFG
+ */
+
+#define MEM_SIZE 4096
+#define ROM_START 0x200
+
+
+typedef struct Rom {
+    uint8_t mem[MEM_SIZE];   // ROM as laid out in Chip-8 memory
+    uint16_t end;            // One past the last ROM byte
+    bool reached[MEM_SIZE];  // Address is the start of a reachable instruction
+    bool leader[MEM_SIZE];   // Address starts a basic block
+} Rom;
+
+
+/**
+ * Read the instruction at addr
+ */
+static uint16_t opcode_at(const Rom* rom, uint16_t addr) {
+    return (rom->mem[addr] << 8) | rom->mem[addr + 1];
+}
+
+
+/**
+ * Check whether a whole instruction at addr lies inside the ROM
+ */
+static bool in_rom(const Rom* rom, uint32_t addr) {
+    return addr >= ROM_START && addr + 1 < rom->end;
+}
+
+
+/**
+ * Check whether an instruction ends a basic block
+ * Besides control flow, FX0A (may re-run itself) and instructions that
+ * write memory (FX33, FX55) end a block, so code they overwrite is
+ * re-validated before it runs.
+ */
+static bool ends_block(uint16_t op) {
+    uint8_t lsb = op & 0xFF;
+
+    switch (op >> 12) {
+        case (0x0):
+            return op == 0x00EE;
+        case (0x1):
+        case (0x2):
+        case (0x3):
+        case (0x4):
+        case (0x5):
+        case (0x9):
+        case (0xB):
+            return true;
+        case (0xE):
+            return lsb == 0x9E || lsb == 0xA1;
+        case (0xF):
+            return lsb == 0x0A || lsb == 0x33 || lsb == 0x55;
+        default:
+            return false;
+    }
+}
+
+
+/**
+ * Find the statically known successors of the instruction at addr
+ * Returns how many were stored in succ. 00EE and BNNN have none:
+ * their targets are only known at runtime.
+ */
+static int successors(uint16_t addr, uint16_t op, uint16_t succ[2]) {
+    uint16_t nnn = op & 0xFFF;
+
+    switch (op >> 12) {
+        case (0x1): // 1NNN
+            succ[0] = nnn;
+            return 1;
+        case (0x2): // 2NNN - also returns to the next instruction
+            succ[0] = nnn;
+            succ[1] = addr + 2;
+            return 2;
+        case (0xB): // BNNN
+            return 0;
+        case (0x0):
+            if (op == 0x00EE)
+                return 0;
+            break;
+        default:
+            if (ends_block(op) && (op >> 12) != 0xF) { // Skips
+                succ[0] = addr + 2;
+                succ[1] = addr + 4;
+                return 2;
+            }
+            break;
+    }
+
+    succ[0] = addr + 2;
+    return 1;
+}
+
+
+/**
+ * Write a human readable form of an instruction into buf
+ */
+static void disassemble(uint16_t op, char* buf, size_t len) {
+    uint8_t x = (op >> 8) & 0xF;
+    uint8_t y = (op >> 4) & 0xF;
+    uint8_t n = op & 0xF;
+    uint8_t nn = op & 0xFF;
+    uint16_t nnn = op & 0xFFF;
+
+    switch (op >> 12) {
+        case (0x0):
+            if (op == 0x00E0)
+                snprintf(buf, len, "CLS");
+            else if (op == 0x00EE)
+                snprintf(buf, len, "RET");
+            else
+                snprintf(buf, len, "SYS  0x%03X", nnn);
+            return;
+        case (0x1): snprintf(buf, len, "JP   0x%03X", nnn); return;
+        case (0x2): snprintf(buf, len, "CALL 0x%03X", nnn); return;
+        case (0x3): snprintf(buf, len, "SE   V%X, 0x%02X", x, nn); return;
+        case (0x4): snprintf(buf, len, "SNE  V%X, 0x%02X", x, nn); return;
+        case (0x5): snprintf(buf, len, "SE   V%X, V%X", x, y); return;
+        case (0x6): snprintf(buf, len, "LD   V%X, 0x%02X", x, nn); return;
+        case (0x7): snprintf(buf, len, "ADD  V%X, 0x%02X", x, nn); return;
+        case (0x8):
+            switch (n) {
+                case (0x0): snprintf(buf, len, "LD   V%X, V%X", x, y); return;
+                case (0x1): snprintf(buf, len, "OR   V%X, V%X", x, y); return;
+                case (0x2): snprintf(buf, len, "AND  V%X, V%X", x, y); return;
+                case (0x3): snprintf(buf, len, "XOR  V%X, V%X", x, y); return;
+                case (0x4): snprintf(buf, len, "ADD  V%X, V%X", x, y); return;
+                case (0x5): snprintf(buf, len, "SUB  V%X, V%X", x, y); return;
+                case (0x6): snprintf(buf, len, "SHR  V%X", x); return;
+                case (0x7): snprintf(buf, len, "SUBN V%X, V%X", x, y); return;
+                case (0xE): snprintf(buf, len, "SHL  V%X", x); return;
+            }
+            break;
+        case (0x9): snprintf(buf, len, "SNE  V%X, V%X", x, y); return;
+        case (0xA): snprintf(buf, len, "LD   I, 0x%03X", nnn); return;
+        case (0xB): snprintf(buf, len, "JP   V0, 0x%03X", nnn); return;
+        case (0xC): snprintf(buf, len, "RND  V%X, 0x%02X", x, nn); return;
+        case (0xD): snprintf(buf, len, "DRW  V%X, V%X, %d", x, y, n); return;
+        case (0xE):
+            if (nn == 0x9E) { snprintf(buf, len, "SKP  V%X", x); return; }
+            if (nn == 0xA1) { snprintf(buf, len, "SKNP V%X", x); return; }
+            break;
+        case (0xF):
+            switch (nn) {
+                case (0x07): snprintf(buf, len, "LD   V%X, DT", x); return;
+                case (0x0A): snprintf(buf, len, "LD   V%X, K", x); return;
+                case (0x15): snprintf(buf, len, "LD   DT, V%X", x); return;
+                case (0x18): snprintf(buf, len, "LD   ST, V%X", x); return;
+                case (0x1E): snprintf(buf, len, "ADD  I, V%X", x); return;
+                case (0x29): snprintf(buf, len, "LD   F, V%X", x); return;
+                case (0x33): snprintf(buf, len, "LD   B, V%X", x); return;
+                case (0x55): snprintf(buf, len, "LD   [I], V%X", x); return;
+                case (0x65): snprintf(buf, len, "LD   V%X, [I]", x); return;
+            }
+            break;
+    }
+
+    snprintf(buf, len, "DW   0x%04X", op); // Not an instruction
+    return;
+}
+
+
+/**
+ * Recover the control-flow graph: mark every reachable instruction
+ * and every basic block leader, starting from 0x200
+ */
+static void find_blocks(Rom* rom) {
+    uint16_t worklist[2 * MEM_SIZE]; // Each block end pushes at most 2 successors
+    int count = 0;
+
+    if (!in_rom(rom, ROM_START))
+        return;
+
+    worklist[count++] = ROM_START;
+    rom->leader[ROM_START] = true;
+
+    while (count > 0) {
+        uint16_t addr = worklist[--count];
+
+        // Follow straight-line code until the block ends
+        while (in_rom(rom, addr) && !rom->reached[addr]) {
+            rom->reached[addr] = true;
+            uint16_t op = opcode_at(rom, addr);
+
+            if (!ends_block(op)) {
+                addr += 2;
+                continue;
+            }
+
+            uint16_t succ[2];
+            int n = successors(addr, op, succ);
+            for (int i = 0; i < n; i++) {
+                if (!in_rom(rom, succ[i]))
+                    continue;
+                rom->leader[succ[i]] = true;
+                if (!rom->reached[succ[i]])
+                    worklist[count++] = succ[i];
+            }
+            break;
+        }
+    }
+
+    return;
+}
+
+
+/**
+ * Find the end of the block starting at leader (one past its last instruction)
+ */
+static uint16_t block_end(const Rom* rom, uint16_t leader) {
+    uint16_t addr = leader;
+
+    while (in_rom(rom, addr)) {
+        uint16_t op = opcode_at(rom, addr);
+        addr += 2;
+        if (ends_block(op) || (addr < rom->end && rom->leader[addr]))
+            break;
+    }
+
+    return addr;
+}
+
+
+/**
+ * Find the lowest address of translated code
+ */
+static uint16_t code_start(const Rom* rom) {
+    uint16_t addr = ROM_START;
+    while (addr < rom->end && !rom->leader[addr])
+        addr++;
+    return addr;
+}
+
+
+/**
+ * Find one past the highest address of translated code
+ */
+static uint16_t code_end(const Rom* rom) {
+    uint16_t end = ROM_START;
+    for (uint16_t leader = ROM_START; leader < rom->end; leader++) {
+        if (rom->leader[leader] && block_end(rom, leader) > end)
+            end = block_end(rom, leader);
+    }
+    return end;
+}
+
+
+/**
+ * Print the disassembly of every basic block along with its successors
+ */
+static void dump_cfg(const Rom* rom, FILE* out) {
+    char text[32];
+    int blocks = 0;
+    int instructions = 0;
+
+    for (uint16_t leader = ROM_START; leader < rom->end; leader++) {
+        if (!rom->leader[leader])
+            continue;
+
+        uint16_t end = block_end(rom, leader);
+        uint16_t last = end - 2;
+        uint16_t op = opcode_at(rom, last);
+        uint16_t succ[2];
+        int n = successors(last, op, succ);
+
+        fprintf(out, "block 0x%03X-0x%03X (%d instruction%s) ->",
+            leader, last, (end - leader) / 2, (end - leader == 2) ? "" : "s");
+        if (op == 0x00EE)
+            fprintf(out, " (return)");
+        else if (n == 0)
+            fprintf(out, " (computed)");
+        for (int i = 0; i < n; i++)
+            fprintf(out, " 0x%03X", succ[i]);
+        fprintf(out, "\n");
+
+        for (uint16_t addr = leader; addr < end; addr += 2) {
+            disassemble(opcode_at(rom, addr), text, sizeof(text));
+            fprintf(out, "    0x%03X: %04X  %s\n", addr, opcode_at(rom, addr), text);
+        }
+        fprintf(out, "\n");
+
+        blocks++;
+        instructions += (end - leader) / 2;
+    }
+
+    fprintf(out, "%d blocks, %d instructions, %d of %d ROM bytes reached as code\n",
+        blocks, instructions, instructions * 2, rom->end - ROM_START);
+    return;
+}
+
+
+/**
+ * Emit C for a single instruction
+ * Instructions that end a block set PC and return `executed`; the rest
+ * fall through to the next instruction. Instructions that touch the
+ * display, RNG, keyboard waits or memory writes are handed to the
+ * interpreter so both share one implementation. Memory writes are then
+ * checked against the translated code.
+ */
+static void emit_instruction(FILE* out, uint16_t addr, uint16_t op) {
+    uint8_t x = (op >> 8) & 0xF;
+    uint8_t y = (op >> 4) & 0xF;
+    uint8_t nn = op & 0xFF;
+    uint16_t nnn = op & 0xFFF;
+    bool ends = false;
+    char text[32];
+
+    disassemble(op, text, sizeof(text));
+    fprintf(out, "    // 0x%03X: %04X  %s\n", addr, op, text);
+
+    switch (op >> 12) {
+        case (0x0):
+            if (op == 0x00EE) {
+                fprintf(out, "    chip8->PC = chip8->stack[chip8->SP];\n");
+                fprintf(out, "    chip8->SP--;\n");
+                ends = true;
+            } else if (op == 0x00E0) {
+                goto interpret;
+            }
+            break;
+        case (0x1):
+            fprintf(out, "    chip8->PC = 0x%03X;\n", nnn);
+            ends = true;
+            break;
+        case (0x2):
+            fprintf(out, "    chip8->SP++;\n");
+            fprintf(out, "    chip8->stack[chip8->SP] = 0x%03X;\n", addr + 2);
+            fprintf(out, "    chip8->PC = 0x%03X;\n", nnn);
+            ends = true;
+            break;
+        case (0x3):
+            fprintf(out, "    chip8->PC = (chip8->Vx[0x%X] == 0x%02X) ? 0x%03X : 0x%03X;\n",
+                x, nn, addr + 4, addr + 2);
+            ends = true;
+            break;
+        case (0x4):
+            fprintf(out, "    chip8->PC = (chip8->Vx[0x%X] != 0x%02X) ? 0x%03X : 0x%03X;\n",
+                x, nn, addr + 4, addr + 2);
+            ends = true;
+            break;
+        case (0x5):
+            fprintf(out, "    chip8->PC = (chip8->Vx[0x%X] == chip8->Vx[0x%X]) ? 0x%03X : 0x%03X;\n",
+                x, y, addr + 4, addr + 2);
+            ends = true;
+            break;
+        case (0x6):
+            fprintf(out, "    chip8->Vx[0x%X] = 0x%02X;\n", x, nn);
+            break;
+        case (0x7):
+            fprintf(out, "    chip8->Vx[0x%X] += 0x%02X;\n", x, nn);
+            break;
+        case (0x8):
+            switch (op & 0xF) {
+                case (0x0):
+                    fprintf(out, "    chip8->Vx[0x%X] = chip8->Vx[0x%X];\n", x, y);
+                    break;
+                case (0x1):
+                    fprintf(out, "    chip8->Vx[0x%X] |= chip8->Vx[0x%X];\n", x, y);
+                    break;
+                case (0x2):
+                    fprintf(out, "    chip8->Vx[0x%X] &= chip8->Vx[0x%X];\n", x, y);
+                    break;
+                case (0x3):
+                    fprintf(out, "    chip8->Vx[0x%X] ^= chip8->Vx[0x%X];\n", x, y);
+                    break;
+                case (0x4):
+                    fprintf(out, "    {\n");
+                    fprintf(out, "        uint16_t sum = chip8->Vx[0x%X] + chip8->Vx[0x%X];\n", x, y);
+                    fprintf(out, "        chip8->Vx[0x%X] = (uint8_t) sum;\n", x);
+                    fprintf(out, "        chip8->Vx[0xF] = (sum > 255) ? 1 : 0;\n");
+                    fprintf(out, "    }\n");
+                    break;
+                case (0x5):
+                    fprintf(out, "    {\n");
+                    fprintf(out, "        bool underflow = chip8->Vx[0x%X] > chip8->Vx[0x%X];\n", y, x);
+                    fprintf(out, "        chip8->Vx[0x%X] -= chip8->Vx[0x%X];\n", x, y);
+                    fprintf(out, "        chip8->Vx[0xF] = underflow ? 0 : 1;\n");
+                    fprintf(out, "    }\n");
+                    break;
+                case (0x6):
+                    fprintf(out, "    {\n");
+                    fprintf(out, "        uint8_t bit = chip8->Vx[0x%X] & 0x01;\n", x);
+                    fprintf(out, "        chip8->Vx[0x%X] >>= 1;\n", x);
+                    fprintf(out, "        chip8->Vx[0xF] = bit;\n");
+                    fprintf(out, "    }\n");
+                    break;
+                case (0x7):
+                    fprintf(out, "    {\n");
+                    fprintf(out, "        bool underflow = chip8->Vx[0x%X] > chip8->Vx[0x%X];\n", x, y);
+                    fprintf(out, "        chip8->Vx[0x%X] = chip8->Vx[0x%X] - chip8->Vx[0x%X];\n", x, y, x);
+                    fprintf(out, "        chip8->Vx[0xF] = underflow ? 0 : 1;\n");
+                    fprintf(out, "    }\n");
+                    break;
+                case (0xE):
+                    fprintf(out, "    {\n");
+                    fprintf(out, "        uint8_t bit = (chip8->Vx[0x%X] & 0x80) >> 7;\n", x);
+                    fprintf(out, "        chip8->Vx[0x%X] <<= 1;\n", x);
+                    fprintf(out, "        chip8->Vx[0xF] = bit;\n");
+                    fprintf(out, "    }\n");
+                    break;
+            }
+            break;
+        case (0x9):
+            fprintf(out, "    chip8->PC = (chip8->Vx[0x%X] != chip8->Vx[0x%X]) ? 0x%03X : 0x%03X;\n",
+                x, y, addr + 4, addr + 2);
+            ends = true;
+            break;
+        case (0xA):
+            fprintf(out, "    chip8->I = 0x%03X;\n", nnn);
+            break;
+        case (0xB): // Computed jump: the dispatcher resolves the target
+            fprintf(out, "    chip8->PC = 0x%03X + chip8->Vx[0x0];\n", nnn);
+            ends = true;
+            break;
+        case (0xC):
+        case (0xD):
+            goto interpret;
+        case (0xE):
+            if (nn == 0x9E || nn == 0xA1) {
+                fprintf(out, "    chip8->PC = (chip8->keyboard.pressed[chip8->Vx[0x%X] & 0xF] == %d) ? 0x%03X : 0x%03X;\n",
+                    x, (nn == 0x9E) ? 1 : 0, addr + 4, addr + 2);
+                ends = true;
+            }
+            break;
+        case (0xF):
+            switch (nn) {
+                case (0x07):
+                    fprintf(out, "    chip8->Vx[0x%X] = chip8->delay_timer;\n", x);
+                    break;
+                case (0x15):
+                    fprintf(out, "    chip8->delay_timer = chip8->Vx[0x%X];\n", x);
+                    break;
+                case (0x18):
+                    fprintf(out, "    chip8->sound_timer = chip8->Vx[0x%X];\n", x);
+                    break;
+                case (0x1E):
+                    fprintf(out, "    chip8->I += chip8->Vx[0x%X];\n", x);
+                    break;
+                case (0x29):
+                    fprintf(out, "    chip8->I = chip8->Vx[0x%X] * 5;\n", x);
+                    break;
+                case (0x65):
+                    fprintf(out, "    for (int i = 0; i <= 0x%X; i++)\n", x);
+                    fprintf(out, "        chip8->Vx[i] = chip8->mem[chip8->I + i];\n");
+                    break;
+                case (0x0A):
+                case (0x33):
+                case (0x55):
+                    goto interpret;
+            }
+            break;
+    }
+
+    if (ends)
+        fprintf(out, "    return executed;\n");
+    return;
+
+    interpret:
+    fprintf(out, "    chip8->PC = 0x%03X;\n", addr);
+    fprintf(out, "    fetch_decode_execute(chip8);\n");
+    if ((op >> 12) == 0xF && (nn == 0x33 || nn == 0x55)) // Wrote to memory at I
+        fprintf(out, "    check_written(chip8, chip8->I, %d);\n", (nn == 0x33) ? 3 : x + 1);
+    if (ends_block(op))
+        fprintf(out, "    return executed;\n");
+    return;
+}
+
+
+/**
+ * Emit the C translation unit: one function per basic block, a table
+ * mapping addresses to blocks, and the run_translated() dispatcher
+ */
+static void emit_c(const Rom* rom, const char* rom_name, FILE* out) {
+    fprintf(out, "/*\n");
+    fprintf(out, " * Generated by ./translate from %s -- do not edit.\n", rom_name);
+    fprintf(out, " */\n\n");
+    fprintf(out, "#include \"translated.h\"\n\n\n");
+
+    // Original ROM bytes, used to detect self-modified code
+    fprintf(out, "static const uint8_t rom[%d] = {", rom->end - ROM_START);
+    for (uint16_t addr = ROM_START; addr < rom->end; addr++) {
+        if ((addr - ROM_START) % 12 == 0)
+            fprintf(out, "\n    ");
+        fprintf(out, "0x%02X,%s", rom->mem[addr],
+            ((addr - ROM_START) % 12 == 11 || addr + 1 == rom->end) ? "" : " ");
+    }
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "typedef int (*Block)(Chip8* chip8, int budget);\n\n");
+    fprintf(out, "static void check_written(Chip8* chip8, int start, int len);\n\n\n");
+
+    /*
+     * One function per basic block. Every instruction is a case of the
+     * switch, so a block can resume where the previous budget ran out.
+     */
+    for (uint16_t leader = ROM_START; leader < rom->end; leader++) {
+        if (!rom->leader[leader])
+            continue;
+
+        uint16_t end = block_end(rom, leader);
+
+        fprintf(out, "static int block_%03X(Chip8* chip8, int budget) {\n", leader);
+        fprintf(out, "    int executed = 0;\n");
+        if (end - leader == 2)
+            fprintf(out, "    (void)budget;\n");
+        fprintf(out, "\n    switch (chip8->PC) {\n");
+        for (uint16_t addr = leader; addr < end; addr += 2) {
+            if (addr > leader)
+                fprintf(out, "    // fall through\n");
+            fprintf(out, "    case 0x%03X:\n", addr);
+            if (addr > leader) { // Stop exactly when the budget runs out
+                fprintf(out, "    if (executed == budget) {\n");
+                fprintf(out, "        chip8->PC = 0x%03X;\n", addr);
+                fprintf(out, "        return executed;\n");
+                fprintf(out, "    }\n");
+            }
+            fprintf(out, "    executed++;\n");
+            emit_instruction(out, addr, opcode_at(rom, addr));
+        }
+        fprintf(out, "    }\n\n");
+
+        if (!ends_block(opcode_at(rom, end - 2))) { // Fall through
+            fprintf(out, "    chip8->PC = 0x%03X;\n", end);
+            fprintf(out, "    return executed;\n");
+        } else {
+            fprintf(out, "    return executed; // Unreachable: every entry point is a case above\n");
+        }
+        fprintf(out, "}\n\n");
+    }
+
+    // Every instruction address inside a block, and the block it belongs to
+    fprintf(out, "\nstatic const Block translated[4096] = {\n");
+    for (uint16_t leader = ROM_START; leader < rom->end; leader++) {
+        if (!rom->leader[leader])
+            continue;
+        uint16_t end = block_end(rom, leader);
+        for (uint16_t addr = leader; addr < end; addr += 2)
+            fprintf(out, "    [0x%03X] = block_%03X,\n", addr, leader);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const struct {\n");
+    fprintf(out, "    uint16_t start;\n");
+    fprintf(out, "    uint16_t len;            // Size of the block in bytes\n");
+    fprintf(out, "} ranges[] = {\n");
+    for (uint16_t leader = ROM_START; leader < rom->end; leader++) {
+        if (rom->leader[leader])
+            fprintf(out, "    { 0x%03X, %d },\n", leader, block_end(rom, leader) - leader);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out,
+        "// Blocks whose code is still intact; NULL runs the interpreter\n"
+        "static Block blocks[4096];\n"
+        "static bool validated = false;\n"
+        "\n"
+        "\n"
+        "/**\n"
+        " * Enable or disable the blocks overlapping a range of memory that was\n"
+        " * just written, depending on whether their code still matches the ROM\n"
+        " */\n"
+        "static void check_written(Chip8* chip8, int start, int len) {\n"
+        "    if (start + len <= 0x%03X || start >= 0x%03X) // Outside translated code\n"
+        "        return;\n"
+        "\n"
+        "    for (size_t i = 0; i < sizeof(ranges) / sizeof(ranges[0]); i++) {\n"
+        "        int block_start = ranges[i].start;\n"
+        "        int block_end = block_start + ranges[i].len;\n"
+        "        if (block_end <= start || block_start >= start + len)\n"
+        "            continue;\n"
+        "\n"
+        "        bool intact = memcmp(&chip8->mem[block_start],\n"
+        "            &rom[block_start - 0x200], ranges[i].len) == 0;\n"
+        "        for (int addr = block_start; addr < block_end; addr += 2)\n"
+        "            blocks[addr] = intact ? translated[addr] : NULL;\n"
+        "    }\n"
+        "\n"
+        "    return;\n"
+        "}\n"
+        "\n"
+        "\n"
+        "/**\n"
+        " * Run a single instruction through the interpreter\n"
+        " */\n"
+        "static void interpret(Chip8* chip8) {\n"
+        "    uint16_t pc = chip8->PC;\n"
+        "\n"
+        "    // Decode before executing: FX55 may overwrite its own bytes\n"
+        "    uint8_t msb = (pc < 4095) ? chip8->mem[pc] : 0;\n"
+        "    uint8_t lsb = (pc < 4095) ? chip8->mem[pc + 1] : 0;\n"
+        "    bool writes = (msb >> 4) == 0xF && (lsb == 0x33 || lsb == 0x55);\n"
+        "\n"
+        "    fetch_decode_execute(chip8);\n"
+        "\n"
+        "    if (writes) // FX33 or FX55 wrote to memory at I\n"
+        "        check_written(chip8, chip8->I, (lsb == 0x33) ? 3 : (msb & 0xF) + 1);\n"
+        "    return;\n"
+        "}\n"
+        "\n"
+        "\n"
+        "/**\n"
+        " * Forget which blocks are intact, e.g. after loading the ROM again\n"
+        " */\n"
+        "void reset_translated(void) {\n"
+        "    validated = false;\n"
+        "    return;\n"
+        "}\n"
+        "\n"
+        "\n"
+        "/**\n"
+        " * Run a ROM that was translated ahead-of-time to C by ./translate\n"
+        " * Falls back to the interpreter for addresses that aren't in a block\n"
+        " * and for blocks whose code has changed since translation\n"
+        " */\n"
+        "int run_translated(Chip8* chip8, int budget) {\n"
+        "    int executed = 0;\n"
+        "\n"
+        "    if (!validated) { // Check the loaded ROM matches the translation\n"
+        "        validated = true;\n"
+        "        check_written(chip8, 0x200, sizeof(rom));\n"
+        "    }\n"
+        "\n"
+        "    while (executed < budget) {\n"
+        "        Block block = (chip8->PC < 4096) ? blocks[chip8->PC] : NULL;\n"
+        "\n"
+        "        if (block != NULL) {\n"
+        "            executed += block(chip8, budget - executed);\n"
+        "        } else {\n"
+        "            interpret(chip8);\n"
+        "            executed++;\n"
+        "        }\n"
+        "    }\n"
+        "\n"
+        "    return executed;\n"
+        "}\n",
+        code_start(rom), code_end(rom));
+    return;
+}
+
+
+int main(int argc, char** argv) {
+    bool dump = false;
+    const char* out_path = NULL;
+    const char* rom_path = NULL;
+
+    bool usage_error = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0)
+            dump = true;
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out_path = argv[++i];
+        else if (argv[i][0] == '-' || rom_path != NULL)
+            usage_error = true; // Unknown flag, -o without a path, or a second ROM
+        else
+            rom_path = argv[i];
+    }
+
+    if (usage_error || rom_path == NULL) {
+        fprintf(stderr, "Usage: %s [-d] [-o out.c] /path/to/game_rom.ch8\n", argv[0]);
+        return 1;
+    }
+
+    // Load ROM at the same place the interpreter does
+    static Rom rom;
+    FILE* rom_file = fopen(rom_path, "rb");
+    if (rom_file == NULL) {
+        fprintf(stderr, "Couldn't open %s\n", rom_path);
+        return 1;
+    }
+    rom.end = ROM_START + fread(&rom.mem[ROM_START], 1, MEM_SIZE - ROM_START, rom_file);
+    fclose(rom_file);
+
+    if (!in_rom(&rom, ROM_START)) { // Not even one instruction
+        fprintf(stderr, "%s is empty\n", rom_path);
+        return 1;
+    }
+
+    find_blocks(&rom);
+
+    FILE* out = stdout;
+    if (out_path != NULL) {
+        out = fopen(out_path, "w");
+        if (out == NULL) {
+            fprintf(stderr, "Couldn't open %s\n", out_path);
+            return 1;
+        }
+    }
+
+    if (dump)
+        dump_cfg(&rom, out);
+    else
+        emit_c(&rom, rom_path, out);
+
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}
@@ -0,0 +1,26 @@
+#ifndef _TRANSLATED_H_
+#define _TRANSLATED_H_
+
+#include "chip8.h"
+
+
+/**
+ * Run a ROM that was translated ahead-of-time to C by ./translate
+ * Executes exactly `budget` instructions and returns how many were run.
+ * Any address the translator couldn't resolve (BNNN targets, code that has
+ * been overwritten since translation) falls back to fetch_decode_execute()
+ * Blocks are checked once against memory on the first call, then only
+ * again where FX33/FX55 write over translated code
+ */
+int run_translated(Chip8* chip8, int budget);
+
+
+/**
+ * Forget which translated blocks are intact
+ * Call after resetting memory or loading the ROM again; the next
+ * run_translated() re-checks memory against the translation
+ */
+void reset_translated(void);
+
+
+#endif